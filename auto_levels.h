@@ -0,0 +1,13 @@
+#pragma once
+#include "file_work.h"
+#include "filters.h"
+
+// Auto-levels (contrast stretch) filter:
+class AutoLevels : public BaseFilter {
+private:
+    double clip_ = 0;  // Fraction of pixels allowed to saturate at each end of every channel
+
+public:
+    bool ParamChecker(const FilterStep& step) override;
+    Image Implement(const FilterStep& step, Image& original) override;
+};
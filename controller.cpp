@@ -1,29 +1,58 @@
+#include <algorithm>
+#include <memory>
+
 #include "controller.h"
+#include "auto_levels.h"
 #include "crop.h"
 #include "edge_detection.h"
+#include "equalize.h"
+#include "flip.h"
 #include "grey_scale.h"
 #include "negative.h"
+#include "rotate.h"
 #include "sharpening.h"
 
 
-Image Controller(Image& image, FileEntry& info) {
-    for (const auto& i : info.filters_) {
-        if (i == "-gs") {
-            GreyScale gs;
-            image = gs.Implement(info, image);
-        } else if (i == "-neg") {
-            Negative neg;
-            image = neg.Implement(info, image);
-        } else if (i == "-crop") {
-            Crop crop;
-            image = crop.Implement(info, image);
-        } else if (i == "-sharp") {
-            Sharpening sharp;
-            image = sharp.Implement(info, image);
-        } else if (i == "-edge") {
-            Edge edge;
-            image = edge.Implement(info, image);
-        }
+static std::unique_ptr<BaseFilter> MakeFilter(FilterKind kind) {
+    switch (kind) {
+        case FilterKind::GREY_SCALE:
+            return std::make_unique<GreyScale>();
+        case FilterKind::NEGATIVE:
+            return std::make_unique<Negative>();
+        case FilterKind::CROP:
+            return std::make_unique<Crop>();
+        case FilterKind::SHARPENING:
+            return std::make_unique<Sharpening>();
+        case FilterKind::EDGE:
+            return std::make_unique<Edge>();
+        case FilterKind::EQUALIZE:
+            return std::make_unique<Equalize>();
+        case FilterKind::AUTO_LEVELS:
+            return std::make_unique<AutoLevels>();
+        case FilterKind::ROTATE:
+            return std::make_unique<Rotate>();
+        case FilterKind::FLIP_HORIZONTAL:
+            return std::make_unique<FlipHorizontal>();
+        case FilterKind::FLIP_VERTICAL:
+            return std::make_unique<FlipVertical>();
+    }
+    throw std::invalid_argument("Invalid filter: not realised in this program.");
+}
+
+Image Controller(Image image, const FilterChain& chain) {
+    // Filters index the canvas by width_ and height_, so a caller-built image must agree with them:
+    if (image.canvas_.size() != image.height_ ||
+        std::any_of(image.canvas_.begin(), image.canvas_.end(),
+                    [&image](const auto& v) { return v.size() != image.width_; })) {
+        throw std::invalid_argument("Image canvas does not match its width and height.");
+    }
+    std::vector<std::unique_ptr<BaseFilter>> filters;
+    for (const auto& step : chain) {  // A bad step anywhere in the chain is reported before any filter runs
+        filters.push_back(MakeFilter(step.kind_));
+        filters.back()->ParamChecker(step);
+    }
+    for (size_t i = 0; i < chain.size(); ++i) {
+        image = filters[i]->Implement(chain[i], image);
     }
     return image;
 }
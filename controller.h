@@ -1,4 +1,6 @@
 #pragma once
 #include "file_work.h"
 
-Image Controller(Image& image, FileEntry& info);
+// Applies the chain to the image and returns the result. Every step is checked before the first one runs;
+// pass the image with std::move to avoid copying it.
+Image Controller(Image image, const FilterChain& chain);
@@ -9,6 +9,6 @@ private:
     unsigned long height_;
 
 public:
-    bool ParamChecker(FileEntry& user_args) override;
-    Image Implement(FileEntry& user_args, Image& original) override;
+    bool ParamChecker(const FilterStep& step) override;
+    Image Implement(const FilterStep& step, Image& original) override;
 };
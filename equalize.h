@@ -0,0 +1,10 @@
+#pragma once
+#include "file_work.h"
+#include "filters.h"
+
+// Histogram equalization filter:
+class Equalize : public BaseFilter {
+public:
+    bool ParamChecker(const FilterStep& step) override;
+    Image Implement(const FilterStep& step, Image& original) override;
+};
@@ -1,120 +1,122 @@
+#include <algorithm>
+#include <iterator>
+
 #include "file_work.h"
 
-FileEntry Parsing(int argc, char* argv[]) {
-    if (argc < 3) {
-        throw std::invalid_argument(
-            "\nWrong number of arguments submitted. \nThis program uses the format: "
-            "{program name} {read-file path} {write-file path} + {- filter flags and parameters}. "
-            "\nIt can apply greyscale, crop, negative, sharp, and edge-detection filters to BMP images.");
-    }
-    FileEntry user_args;
-    user_args.program_name_ = argv[0];
-    user_args.file_in_ = argv[1];
-    user_args.file_out_ = argv[2];
-    for (auto i = 3; i < argc;) {
-        if (argv[i][0] == '-') {
-            std::string curr_filter = argv[i];
-            if (user_args.REALISED_FILTERS.find(curr_filter) == user_args.REALISED_FILTERS.end()) {
-                throw std::invalid_argument("Invalid filter flag: \"" + std::string(curr_filter) +
-                                            "\" not realised in this program.");
-            }
-            user_args.filters_.push_back(curr_filter);
-            ++i;
-            while (i < argc && argv[i][0] != '-') {
-                user_args.filter_attributes_[curr_filter].push_back(argv[i]);
-                ++i;
-            }
-        } else {
-            throw std::invalid_argument(
-                "These are not the droids you are looking for. Use a filter flag starting with \"–\".");
-        }
+// Little-endian bytes to number:
+static size_t EndianIntConverter(const uint8_t* object, size_t position, size_t bytes) {
+    size_t result = 0;
+    for (size_t i = bytes; i > 0; --i) {
+        result <<= BITS_PER_BYTE;
+        result += object[position + i - 1];
     }
-    return user_args;
+    return result;
 }
 
-std::string HexAsciiConverter(char* const array_ptr, size_t start, size_t end) {
-    std::string result;
-    std::stringstream ss;
-    for (size_t i = start; i < end; ++i) {
-        ss << array_ptr[i];
-    }
-    ss >> std::hex >> result;
-    return result;
+size_t RowPadding(size_t width) {
+    return (4 - width * BYTES_PPX % 4) % 4;
 }
 
-size_t EndianCharIntConverter(const char* object, size_t position) {
-    size_t result = static_cast<uint8_t>(object[position + 1]);
-    result <<= 8;
-    result += static_cast<size_t>(object[position]);
-    return result;
+void UpdateRowSize(Image& image) {
+    image.real_size_ = image.width_ * BYTES_PPX;
+    image.padding_ = RowPadding(image.width_);
 }
 
-Image LoadFile(const std::string& file_name) {
-    std::ifstream file(file_name, std::ios::binary);
+Image DecodeBmp(const uint8_t* data, size_t size) {
     Image our_image;
-    file.read(our_image.header_, 54);
-    if (!file) {
+    if (size < HEADER_SIZE) {
         throw std::invalid_argument("Cannot read image file.");
     }
-    if (HexAsciiConverter(our_image.header_, 0, 2) != "BM") {
+    std::copy(data, data + HEADER_SIZE, reinterpret_cast<uint8_t*>(our_image.header_));
+    if (data[0] != BMP_SIGNATURE_BYTE_1 || data[1] != BMP_SIGNATURE_BYTE_2) {
         throw std::invalid_argument("File does not contain BMP signature in header.");
     }
 
-    our_image.width_ = EndianCharIntConverter(our_image.header_, 18);
-    our_image.height_ = EndianCharIntConverter(our_image.header_, 22);
-    if (!our_image.width_ || !our_image.height_) {
+    our_image.width_ = EndianIntConverter(data, 18, BYTES_PER_INT);
+    our_image.height_ = EndianIntConverter(data, 22, BYTES_PER_INT);
+    if (!our_image.width_ || !our_image.height_ || our_image.width_ > MAX_SIDE || our_image.height_ > MAX_SIDE) {
         throw std::invalid_argument("Image size could not be processed.");
     }
-    our_image.data_offset_ = EndianCharIntConverter(our_image.header_, 10);
-    if (our_image.data_offset_ != 54) {
+    size_t data_offset = EndianIntConverter(data, 10, BYTES_PER_INT);
+    if (data_offset != HEADER_SIZE) {
         throw std::invalid_argument("Image header offset does not accord with BMP format.");
     }
-    our_image.bits_ppx_ = EndianCharIntConverter(our_image.header_, 28);
+    our_image.data_offset_ = static_cast<uint16_t>(data_offset);
+    our_image.bits_ppx_ = EndianIntConverter(data, 28, 2);
     if (our_image.bits_ppx_ != 24) {
         throw std::invalid_argument("Image must be 24-bit BMP to work in this program.");
     }
     our_image.bytes_ppx_ = our_image.bits_ppx_ / 8;
+    UpdateRowSize(our_image);
+    size_t row_size = our_image.real_size_ + our_image.padding_;
+    // Dividing instead of multiplying keeps the check itself from overflowing:
+    if (row_size > (size - data_offset) / our_image.height_) {
+        throw std::invalid_argument("Image data is shorter than its header declares.");
+    }
     our_image.canvas_ = std::vector<std::vector<PIXEL>>(our_image.height_, std::vector<PIXEL>(our_image.width_));
-    our_image.real_size_ = our_image.bytes_ppx_ * our_image.width_;
-    our_image.padding_ = (4 - our_image.real_size_ % 4) % 4;
-    size_t start = our_image.data_offset_;
-    size_t end = start + our_image.real_size_;
-    for (size_t i = 0; i < our_image.height_; ++i) {
-        file.seekg(start);
-        for (size_t j = start; j < end;) {
-            file.read(reinterpret_cast<char*>(&our_image.canvas_[i][(j - start) / 3].b), 1);
-            file.read(reinterpret_cast<char*>(&our_image.canvas_[i][(j - start) / 3].g), 1);
-            file.read(reinterpret_cast<char*>(&our_image.canvas_[i][(j - start) / 3].r), 1);
-            j += 3;
+    // Pixels are converted straight from the caller's buffer, B G R order in the file:
+    const uint8_t* row = data + data_offset;
+    for (auto& v : our_image.canvas_) {
+        const uint8_t* byte = row;
+        for (auto& p : v) {
+            p.b = byte[0];
+            p.g = byte[1];
+            p.r = byte[2];
+            byte += 3;
         }
-        start = end + our_image.padding_;
-        end = start + our_image.real_size_;
+        row += row_size;
     }
     return our_image;
 }
 
-void WriteByte(std::ostream& out, uint8_t value) {  // Write bytes to binary output stream
-    out.write(reinterpret_cast<char*>(&value), 1);
+Image LoadFile(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    if (!file) {
+        throw std::invalid_argument("Cannot read image file.");
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return DecodeBmp(data.data(), data.size());
+}
+
+static void WriteByte(uint8_t*& out, uint8_t value) {  // Write byte to output buffer and move past it
+    *out++ = value;
 }
 
-void WriteInt(std::ostream& out, uint32_t value) {  // Write int to binary output stream
+static void WriteInt(uint8_t*& out, uint32_t value) {  // Write int to output buffer
     for (size_t i = 0; i < BYTES_PER_INT; ++i) {  // Loop for all bytes in i variable
         WriteByte(out, (value >> (i * BITS_PER_BYTE)) & BYTE_MASK); // Consecutively highlighting all bytes in number
     }
 }
 
-void WriteZeros(std::ostream& out, size_t count) {  // Write to output stream the number (count) of bytes equal to 0
+// Write to output buffer the number (count) of bytes equal to 0:
+static void WriteZeros(uint8_t*& out, size_t count) {
     for (size_t i = 0; i < count; ++i) {
         WriteByte(out, 0);
     }
 }
 
-void SaveFile(const std::string& file_name, const Image& image) {
-    std::ofstream out(file_name, std::ios::binary);
+size_t EncodedBmpSize(const Image& image) {
+    // Worked out from width_ alone, so an image whose cached real_size_ and padding_ are stale still encodes:
+    return HEADER_SIZE + image.height_ * (image.width_ * BYTES_PPX + RowPadding(image.width_));
+}
+
+size_t EncodeBmp(const Image& image, uint8_t* buffer, size_t capacity) {
+    auto file_size = EncodedBmpSize(image);
+    if (file_size > UINT32_MAX) {
+        throw std::invalid_argument("Image is too large for the BMP format.");
+    }
+    if (capacity < file_size) {
+        throw std::invalid_argument("Output buffer is too small for the image.");
+    }
+    if (image.canvas_.size() != image.height_ ||
+        std::any_of(image.canvas_.begin(), image.canvas_.end(),
+                    [&image](const auto& v) { return v.size() != image.width_; })) {
+        throw std::invalid_argument("Image canvas does not match its width and height.");
+    }
+    uint8_t* out = buffer;
     // Пишем header:
     WriteByte(out, BMP_SIGNATURE_BYTE_1);
     WriteByte(out, BMP_SIGNATURE_BYTE_2);
-    auto file_size = HEADER_SIZE + image.height_ * (image.width_ * 3 + image.padding_);
     WriteInt(out, file_size);
     WriteZeros(out, 4);
     WriteInt(out, HEADER_SIZE);
@@ -130,12 +132,29 @@ void SaveFile(const std::string& file_name, const Image& image) {
     WriteZeros(out, PLANES);
     WriteZeros(out, BITS_PPX);
     // Пишем картинку:
-    for (size_t i = 0; i < image.height_; ++i) {
-        for (size_t j = 0; j < image.width_; ++j) {
-            WriteByte(out, image.canvas_[i][j].b);
-            WriteByte(out, image.canvas_[i][j].g);
-            WriteByte(out, image.canvas_[i][j].r);
+    size_t padding = RowPadding(image.width_);
+    for (const auto& v : image.canvas_) {
+        for (const auto& p : v) {
+            WriteByte(out, p.b);
+            WriteByte(out, p.g);
+            WriteByte(out, p.r);
         }
-        WriteZeros(out, image.padding_);
+        WriteZeros(out, padding);
+    }
+    return file_size;
+}
+
+std::vector<uint8_t> EncodeBmp(const Image& image) {
+    std::vector<uint8_t> result(EncodedBmpSize(image));
+    EncodeBmp(image, result.data(), result.size());
+    return result;
+}
+
+void SaveFile(const std::string& file_name, const Image& image) {
+    std::ofstream out(file_name, std::ios::binary);
+    std::vector<uint8_t> data = EncodeBmp(image);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!out) {
+        throw std::invalid_argument("Cannot write image file.");
     }
 }
@@ -1,25 +1,33 @@
 #pragma once
+#include <cstdint>
 #include <fstream>
 #include <iostream>
-#include <map>
-#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <utility>
 
-// Working with the command line:
-class FileEntry {  // Class for storing command line arguments
+// Describing the filters to apply:
+enum class FilterKind {
+    GREY_SCALE,       // -gs
+    NEGATIVE,         // -neg
+    CROP,             // -crop height width
+    SHARPENING,       // -sharp
+    EDGE,             // -edge threshold
+    EQUALIZE,         // -equalize
+    AUTO_LEVELS,      // -autolevels [clip]
+    ROTATE,           // -rotate angle
+    FLIP_HORIZONTAL,  // -flipH
+    FLIP_VERTICAL     // -flipV
+};
+
+class FilterStep {  // One filter of the chain with its numeric parameters, in the order listed for its kind
 public:
-    std::string program_name_;
-    std::string file_in_;
-    std::string file_out_;
-    std::vector<std::string> filters_;
-    std::map<std::string, std::vector<std::string>> filter_attributes_;
-    std::set<std::string> REALISED_FILTERS = {"-gs", "-crop", "-neg", "-sharp", "-edge"};
+    FilterKind kind_;
+    std::vector<double> params_;
 };
 
-FileEntry Parsing(int argc, char* argv[]);
+using FilterChain = std::vector<FilterStep>;  // Filters are applied in order
 
 // Working with pixels:
 class PIXEL {  // Colour class:
@@ -40,11 +48,20 @@ public:
     uint16_t data_offset_{};
     // Our supplemental variables:
     int bytes_ppx_{};
-    int real_size_{};
-    int padding_{};
+    size_t real_size_{};  // Bytes of pixel data in one row
+    size_t padding_{};    // Zero bytes after each row, up to a multiple of 4
     std::vector<std::vector<PIXEL>> canvas_{};
 };
 
+size_t RowPadding(size_t width);   // Zero bytes after a row of `width` 24-bit pixels, BMP rows are aligned to 4 bytes
+void UpdateRowSize(Image& image);  // Recalculates real_size_ and padding_ from width_, call after width_ changes
+
+// Working with memory buffers:
+Image DecodeBmp(const uint8_t* data, size_t size);  // Reads a BMP held in memory, the buffer is not kept
+size_t EncodedBmpSize(const Image& image);          // Exact number of bytes EncodeBmp writes for this image
+size_t EncodeBmp(const Image& image, uint8_t* buffer, size_t capacity);  // Returns the number of bytes written
+std::vector<uint8_t> EncodeBmp(const Image& image);
+
 // Working with the file:
 Image LoadFile(const std::string& file_name);
 void SaveFile(const std::string& file_name, const Image& image);
@@ -57,6 +74,8 @@ const size_t INFO_HEADER_SIZE = 40;
 const size_t BITS_PER_BYTE = 8;  // Number of bits per byte
 const size_t BYTES_PER_INT = 4;  // Number of bytes in an `int` type variable
 const size_t BYTE_MASK = 0xFF;   // Mask for selecting last byte
+const size_t MAX_SIDE = 1 << 20;  // Largest accepted width or height, in pixels
 
 const size_t PLANES = 1;
 const size_t BITS_PPX = 24;
+const size_t BYTES_PPX = BITS_PPX / BITS_PER_BYTE;
@@ -2,25 +2,29 @@
 #include <cstdlib>
 #include <cmath>
 
+#include "auto_levels.h"
 #include "crop.h"
 #include "edge_detection.h"
+#include "equalize.h"
 #include "filters.h"
+#include "flip.h"
 #include "grey_scale.h"
+#include "histogram.h"
 #include "negative.h"
+#include "rotate.h"
 #include "sharpening.h"
 
 
-bool GreyScale::ParamChecker(FileEntry& user_args) {
-    if (user_args.filter_attributes_.empty() ||
-        user_args.filter_attributes_.find("-gs") == user_args.filter_attributes_.end()) {
+bool GreyScale::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
         return true;
     } else {
         throw std::invalid_argument("Greyscale takes no parameters. Try again.");
     }
 }
 
-Image GreyScale::Implement(FileEntry& user_args, Image& original) {
-    if (ParamChecker(user_args)) {
+Image GreyScale::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
         Image result = original;
         // Iterating over the canvas to apply effect:
         for (auto& v : result.canvas_) {
@@ -34,17 +38,16 @@ Image GreyScale::Implement(FileEntry& user_args, Image& original) {
     throw std::bad_exception();
 }
 
-bool Negative::ParamChecker(FileEntry& user_args) {
-    if (user_args.filter_attributes_.empty() ||
-        user_args.filter_attributes_.find("-neg") == user_args.filter_attributes_.end()) {
+bool Negative::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
         return true;
     } else {
         throw std::invalid_argument("Negative takes no parameters. Try again.");
     }
 }
 
-Image Negative::Implement(FileEntry& user_args, Image& original) {
-    if (ParamChecker(user_args)) {
+Image Negative::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
         Image result = original;
         // Iterating over the canvas to apply effect:
         for (auto& v : result.canvas_) {
@@ -59,25 +62,25 @@ Image Negative::Implement(FileEntry& user_args, Image& original) {
     throw std::bad_exception();
 }
 
-bool Crop::ParamChecker(FileEntry& user_args) {
-    if (user_args.filter_attributes_.empty() ||
-        (user_args.filter_attributes_.find("-crop") == user_args.filter_attributes_.end())) {
+bool Crop::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
         throw std::invalid_argument("Crop takes parameters. Include them and try again.");
-    } else if (user_args.filter_attributes_["-crop"].size() != 2) {
+    } else if (step.params_.size() != 2) {
         throw std::invalid_argument("Crop takes exactly 2 parameters. Include them and try again.");
     } else {
-        height_ = strtol(user_args.filter_attributes_["-crop"][0].c_str(), nullptr, 10);
-        width_ = strtol(user_args.filter_attributes_["-crop"][1].c_str(), nullptr, 10);
-        if (width_ == 0L || height_ == 0L) {
-            throw std::invalid_argument("Crop parameters must be numbers. Try again.");
-        } else {
-            return true;
+        for (auto side : step.params_) {
+            if (!(side >= 1 && side <= MAX_SIDE) || std::floor(side) != side) {
+                throw std::invalid_argument("Crop parameters must be positive whole numbers. Try again.");
+            }
         }
+        height_ = static_cast<unsigned long>(step.params_[0]);
+        width_ = static_cast<unsigned long>(step.params_[1]);
+        return true;
     }
 }
 
-Image Crop::Implement(FileEntry& user_args, Image& original) {
-    if (ParamChecker(user_args)) {
+Image Crop::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
         if (height_ < original.height_) {
             std::reverse(original.canvas_.begin(), original.canvas_.end());
             original.canvas_.resize(height_);
@@ -89,23 +92,26 @@ Image Crop::Implement(FileEntry& user_args, Image& original) {
                 row.resize(width_);
             }
             original.width_ = static_cast<size_t>(width_);
+            UpdateRowSize(original);
         }
         return original;
     }
     throw std::bad_exception();
 }
 
-bool Sharpening::ParamChecker(FileEntry& user_args) {
-    if (user_args.filter_attributes_.empty() ||
-        user_args.filter_attributes_.find("-sharp") == user_args.filter_attributes_.end()) {
+bool Sharpening::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
         return true;
     } else {
         throw std::invalid_argument("Sharpening takes no parameters. Try again.");
     }
 }
 
-Image Sharpening::Implement(FileEntry& user_args, Image& original) {
-    if (ParamChecker(user_args)) {
+Image Sharpening::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
+        if (original.height_ < 2 || original.width_ < 2) {  // The border cases below read both neighbours
+            throw std::invalid_argument("Sharpening needs an image of at least 2x2 pixels.");
+        }
         Image result = original;
         for (size_t i = 0; i < original.height_; ++i) {
             for (size_t j = 0; j < original.width_; ++j) {
@@ -250,28 +256,26 @@ Image Sharpening::Implement(FileEntry& user_args, Image& original) {
     throw std::bad_exception();
 }
 
-bool Edge::ParamChecker(FileEntry& user_args) {
-    if (user_args.filter_attributes_.empty() ||
-        (user_args.filter_attributes_.find("-edge") == user_args.filter_attributes_.end())) {
+bool Edge::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
         throw std::invalid_argument("Edge takes one parameter. Include it and try again.");
-    } else if (user_args.filter_attributes_["-edge"].size() != 1) {
+    } else if (step.params_.size() != 1) {
         throw std::invalid_argument("Edge takes exactly 1 parameter. Try again");
+    } else if (!std::isfinite(step.params_[0])) {
+        throw std::invalid_argument("Edge parameter must be a number. Try again.");
     } else {
-        char* end_ptr;
-        threshold_ = std::lround(strtod(user_args.filter_attributes_["-edge"][0].c_str(), &end_ptr) * 255);
-        if (*end_ptr != '\0') {
-            throw std::invalid_argument("Edge parameter must be a number. Try again.");
-        } else {
-            return true;
-        }
+        threshold_ = std::lround(std::clamp(step.params_[0], 0.0, 1.0) * MAXIMUM);
+        return true;
     }
 }
 
-Image Edge::Implement(FileEntry& user_args, Image& original) {
-    if (ParamChecker(user_args)) {
+Image Edge::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
+        if (original.height_ < 2 || original.width_ < 2) {  // The border cases below read both neighbours
+            throw std::invalid_argument("Edge needs an image of at least 2x2 pixels.");
+        }
         GreyScale gs;
-        user_args.filters_.push_back("-gs");
-        original = gs.Implement(user_args, original);
+        original = gs.Implement(FilterStep{FilterKind::GREY_SCALE, {}}, original);
         Image result = original;
         for (size_t i = 0; i < original.height_; ++i) {
             for (size_t j = 0; j < original.width_; ++j) {
@@ -377,7 +381,159 @@ Image Edge::Implement(FileEntry& user_args, Image& original) {
                 }
             }
         }
-        user_args.filters_.pop_back();
+        return result;
+    }
+    throw std::bad_exception();
+}
+
+bool Equalize::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
+        return true;
+    } else {
+        throw std::invalid_argument("Equalize takes no parameters. Try again.");
+    }
+}
+
+Image Equalize::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
+        // Both passes work on the canvas in place, no second copy of the image is made:
+        Histogram histogram = BuildHistogram(original);
+        // The luminance CDF gives one table for all channels, so neutral greys stay neutral:
+        uint64_t cdf_min = 0;
+        for (auto count : histogram.luma_) {
+            if (count) {
+                cdf_min = count;
+                break;
+            }
+        }
+        if (histogram.total_ == cdf_min) {  // Single-tone image, nothing to spread
+            return std::move(original);
+        }
+        LookUpTable lut{};
+        uint64_t cdf = 0;
+        for (size_t v = 0; v < HISTOGRAM_BINS; ++v) {
+            cdf += histogram.luma_[v];
+            uint64_t above_min = cdf > cdf_min ? cdf - cdf_min : 0;
+            lut[v] = static_cast<uint8_t>(std::lround(static_cast<double>(above_min) * MAXIMUM /
+                                                      static_cast<double>(histogram.total_ - cdf_min)));
+        }
+        ApplyLookUpTables(original, lut, lut, lut);
+        return std::move(original);
+    }
+    throw std::bad_exception();
+}
+
+bool AutoLevels::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
+        clip_ = 0;
+        return true;
+    } else if (step.params_.size() != 1) {
+        throw std::invalid_argument("Autolevels takes at most 1 parameter. Try again.");
+    } else {
+        clip_ = step.params_[0];
+        // Written so that NaN fails the range check as well:
+        if (!(clip_ >= 0 && clip_ < 0.5)) {
+            throw std::invalid_argument("Autolevels parameter must be a number in [0, 0.5). Try again.");
+        } else {
+            return true;
+        }
+    }
+}
+
+Image AutoLevels::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
+        Histogram histogram = BuildHistogram(original);
+        auto clipped = static_cast<uint64_t>(clip_ * static_cast<double>(histogram.total_));
+        ApplyLookUpTables(original, StretchTable(histogram.r_, clipped), StretchTable(histogram.g_, clipped),
+                          StretchTable(histogram.b_, clipped));
+        return std::move(original);
+    }
+    throw std::bad_exception();
+}
+
+bool FlipHorizontal::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
+        return true;
+    } else {
+        throw std::invalid_argument("FlipH takes no parameters. Try again.");
+    }
+}
+
+Image FlipHorizontal::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
+        // Rows are contiguous, so each one is reversed in place without a second canvas:
+        for (auto& row : original.canvas_) {
+            std::reverse(row.begin(), row.end());
+        }
+        return std::move(original);
+    }
+    throw std::bad_exception();
+}
+
+bool FlipVertical::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
+        return true;
+    } else {
+        throw std::invalid_argument("FlipV takes no parameters. Try again.");
+    }
+}
+
+Image FlipVertical::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
+        // Only the row handles are swapped, no pixel is copied:
+        std::reverse(original.canvas_.begin(), original.canvas_.end());
+        return std::move(original);
+    }
+    throw std::bad_exception();
+}
+
+bool Rotate::ParamChecker(const FilterStep& step) {
+    if (step.params_.empty()) {
+        throw std::invalid_argument("Rotate takes one parameter. Include it and try again.");
+    } else if (step.params_.size() != 1) {
+        throw std::invalid_argument("Rotate takes exactly 1 parameter. Try again.");
+    } else if (step.params_[0] != 90 && step.params_[0] != 180 && step.params_[0] != 270) {
+        throw std::invalid_argument("Rotate parameter must be 90, 180, or 270. Try again.");
+    } else {
+        angle_ = static_cast<long>(step.params_[0]);
+        return true;
+    }
+}
+
+Image Rotate::Implement(const FilterStep& step, Image& original) {
+    if (ParamChecker(step)) {
+        if (angle_ == 180) {  // Same as flipping both ways, done in place
+            std::reverse(original.canvas_.begin(), original.canvas_.end());
+            for (auto& row : original.canvas_) {
+                std::reverse(row.begin(), row.end());
+            }
+            return std::move(original);
+        }
+        // Row 0 of the canvas is the bottom of the picture, so clockwise 90 maps [i][j] to [w - 1 - j][i]
+        // and 270 maps [i][j] to [j][h - 1 - i]:
+        std::vector<std::vector<PIXEL>> source = std::move(original.canvas_);
+        Image result = original;
+        size_t h = original.height_;
+        size_t w = original.width_;
+        result.height_ = w;
+        result.width_ = h;
+        UpdateRowSize(result);
+        result.canvas_ = std::vector<std::vector<PIXEL>>(w, std::vector<PIXEL>(h));
+        // Walking tile by tile keeps the rows being read and the rows being written resident in cache,
+        // where a plain column-wise walk would miss on every pixel of a large image:
+        for (size_t ti = 0; ti < h; ti += tile_) {
+            size_t ti_end = std::min(ti + tile_, h);
+            for (size_t tj = 0; tj < w; tj += tile_) {
+                size_t tj_end = std::min(tj + tile_, w);
+                // Each destination row of the tile is written contiguously, gathering one pixel per source row:
+                for (size_t j = tj; j < tj_end; ++j) {
+                    PIXEL* dst_row = angle_ == 90 ? result.canvas_[w - 1 - j].data() : result.canvas_[j].data();
+                    for (size_t i = ti; i < ti_end; ++i) {
+                        dst_row[angle_ == 90 ? i : h - 1 - i] = source[i][j];
+                    }
+                }
+            }
+        }
         return result;
     }
     throw std::bad_exception();
@@ -2,8 +2,10 @@
 #include "file_work.h"
 
 class BaseFilter {  // Abstract class for filter
-    virtual bool ParamChecker(FileEntry& user_args) = 0;
-    virtual Image Implement(FileEntry& user_args, Image& original) = 0;
+public:
+    virtual ~BaseFilter() = default;
+    virtual bool ParamChecker(const FilterStep& step) = 0;
+    virtual Image Implement(const FilterStep& step, Image& original) = 0;
 };
 
 const int MAXIMUM = 255;
@@ -0,0 +1,17 @@
+#pragma once
+#include "file_work.h"
+#include "filters.h"
+
+// Horizontal (mirror) flip filter:
+class FlipHorizontal : public BaseFilter {
+public:
+    bool ParamChecker(const FilterStep& step) override;
+    Image Implement(const FilterStep& step, Image& original) override;
+};
+
+// Vertical (upside-down) flip filter:
+class FlipVertical : public BaseFilter {
+public:
+    bool ParamChecker(const FilterStep& step) override;
+    Image Implement(const FilterStep& step, Image& original) override;
+};
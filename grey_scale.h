@@ -10,6 +10,6 @@ private:
     const double green_ = 0.587;
 
 public:
-    bool ParamChecker(FileEntry& user_args) override;
-    Image Implement(FileEntry& user_args, Image& original) override;
+    bool ParamChecker(const FilterStep& step) override;
+    Image Implement(const FilterStep& step, Image& original) override;
 };
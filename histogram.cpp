@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cmath>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "histogram.h"
+
+const size_t MIN_PIXELS_PER_THREAD = 1 << 16;  // Smaller workloads are not worth spawning a thread for
+
+static size_t ThreadCount(const Image& image) {
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    size_t by_size = image.width_ * image.height_ / MIN_PIXELS_PER_THREAD;
+    return std::clamp(by_size, size_t{1}, std::min(hardware, std::max(image.height_, size_t{1})));
+}
+
+// Runs func(thread, first_row, last_row) for consecutive blocks of rows, one block per thread:
+template <typename Function>
+static void ForEachRowBlock(const Image& image, size_t threads, Function func) {
+    size_t rows_per_thread = (image.height_ + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        size_t first = std::min(t * rows_per_thread, image.height_);
+        size_t last = std::min(first + rows_per_thread, image.height_);
+        try {
+            workers.emplace_back(func, t, first, last);
+        } catch (const std::system_error&) {  // Out of threads: the calling thread does this block itself
+            func(t, first, last);
+        }
+    }
+    func(0, 0, std::min(rows_per_thread, image.height_));  // The calling thread takes the first block itself
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void Histogram::Merge(const Histogram& other) {
+    for (size_t i = 0; i < HISTOGRAM_BINS; ++i) {
+        r_[i] += other.r_[i];
+        g_[i] += other.g_[i];
+        b_[i] += other.b_[i];
+        luma_[i] += other.luma_[i];
+    }
+    total_ += other.total_;
+}
+
+Histogram BuildHistogram(const Image& image) {
+    size_t threads = ThreadCount(image);
+    std::vector<Histogram> partial(threads);
+    ForEachRowBlock(image, threads, [&image, &partial](size_t t, size_t first, size_t last) {
+        // Counted on the thread's own stack, so there is no sharing in the hot loop. Even and odd pixels go to
+        // separate copies so that runs of equal values do not stall on incrementing the same counter:
+        std::array<std::array<HistogramChannel, 4>, 2> local{};
+        uint64_t total = 0;
+        for (size_t i = first; i < last; ++i) {
+            const auto& row = image.canvas_[i];
+            size_t j = 0;
+            for (; j + 1 < row.size(); j += 2) {
+                for (size_t k = 0; k < 2; ++k) {
+                    const PIXEL& p = row[j + k];
+                    ++local[k][0][p.r];
+                    ++local[k][1][p.g];
+                    ++local[k][2][p.b];
+                    ++local[k][3][Luminance(p)];
+                }
+            }
+            if (j < row.size()) {
+                const PIXEL& p = row[j];
+                ++local[0][0][p.r];
+                ++local[0][1][p.g];
+                ++local[0][2][p.b];
+                ++local[0][3][Luminance(p)];
+            }
+            total += row.size();
+        }
+        for (size_t v = 0; v < HISTOGRAM_BINS; ++v) {
+            partial[t].r_[v] = local[0][0][v] + local[1][0][v];
+            partial[t].g_[v] = local[0][1][v] + local[1][1][v];
+            partial[t].b_[v] = local[0][2][v] + local[1][2][v];
+            partial[t].luma_[v] = local[0][3][v] + local[1][3][v];
+        }
+        partial[t].total_ = total;
+    });
+    Histogram result;
+    for (const auto& h : partial) {
+        result.Merge(h);
+    }
+    return result;
+}
+
+void ApplyLookUpTables(Image& image, const LookUpTable& lut_r, const LookUpTable& lut_g, const LookUpTable& lut_b) {
+    ForEachRowBlock(image, ThreadCount(image), [&](size_t, size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            for (auto& p : image.canvas_[i]) {
+                p.r = lut_r[p.r];
+                p.g = lut_g[p.g];
+                p.b = lut_b[p.b];
+            }
+        }
+    });
+}
+
+LookUpTable StretchTable(const HistogramChannel& channel, uint64_t clipped) {
+    size_t low = 0;
+    uint64_t below = channel[low];
+    while (low < HISTOGRAM_BINS - 1 && below <= clipped) {
+        below += channel[++low];
+    }
+    size_t high = HISTOGRAM_BINS - 1;
+    uint64_t above = channel[high];
+    while (high > 0 && above <= clipped) {
+        above += channel[--high];
+    }
+    LookUpTable lut{};
+    for (size_t v = 0; v < HISTOGRAM_BINS; ++v) {
+        if (high <= low) {
+            lut[v] = static_cast<uint8_t>(v);
+        } else if (v <= low) {
+            lut[v] = 0;
+        } else if (v >= high) {
+            lut[v] = HISTOGRAM_BINS - 1;
+        } else {
+            lut[v] = static_cast<uint8_t>(
+                std::lround(static_cast<double>(v - low) * (HISTOGRAM_BINS - 1) / static_cast<double>(high - low)));
+        }
+    }
+    return lut;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "file_work.h"
+
+// Working with image histograms:
+const size_t HISTOGRAM_BINS = 256;  // One bin per possible 8-bit channel value
+
+using HistogramChannel = std::array<uint64_t, HISTOGRAM_BINS>;
+using LookUpTable = std::array<uint8_t, HISTOGRAM_BINS>;
+
+class Histogram {  // Class for storing per-channel and luminance pixel counts
+public:
+    HistogramChannel r_{};
+    HistogramChannel g_{};
+    HistogramChannel b_{};
+    HistogramChannel luma_{};
+    uint64_t total_ = 0;  // Number of pixels counted
+
+    void Merge(const Histogram& other);
+};
+
+// Luminance of a pixel (Rec. 601 weights in 8.8 fixed point, sum to 256):
+inline uint8_t Luminance(const PIXEL& p) {
+    return static_cast<uint8_t>((77 * p.r + 150 * p.g + 29 * p.b) >> 8);
+}
+
+// Counts the whole canvas; rows are split between threads, each filling a private
+// histogram, and the partial results are merged once every thread has finished.
+Histogram BuildHistogram(const Image& image);
+
+// Remaps every pixel through the per-channel look-up tables in a single pass over the canvas.
+void ApplyLookUpTables(Image& image, const LookUpTable& lut_r, const LookUpTable& lut_g, const LookUpTable& lut_b);
+
+// Table mapping [low, high] of the channel onto [0, 255], where `clipped` pixels may fall outside at each end.
+LookUpTable StretchTable(const HistogramChannel& channel, uint64_t clipped);
@@ -1,11 +1,75 @@
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+
 #include "controller.h"
 #include "file_work.h"
 
+// Working with the command line:
+class FileEntry {  // Class for storing command line arguments
+public:
+    std::string program_name_;
+    std::string file_in_;
+    std::string file_out_;
+    FilterChain chain_;
+    std::map<std::string, FilterKind> REALISED_FILTERS = {
+        {"-gs", FilterKind::GREY_SCALE},
+        {"-neg", FilterKind::NEGATIVE},
+        {"-crop", FilterKind::CROP},
+        {"-sharp", FilterKind::SHARPENING},
+        {"-edge", FilterKind::EDGE},
+        {"-equalize", FilterKind::EQUALIZE},
+        {"-autolevels", FilterKind::AUTO_LEVELS},
+        {"-rotate", FilterKind::ROTATE},
+        {"-flipH", FilterKind::FLIP_HORIZONTAL},
+        {"-flipV", FilterKind::FLIP_VERTICAL},
+    };
+};
+
+static FileEntry Parsing(int argc, char* argv[]) {
+    if (argc < 3) {
+        throw std::invalid_argument(
+            "\nWrong number of arguments submitted. \nThis program uses the format: "
+            "{program name} {read-file path} {write-file path} + {- filter flags and parameters}. "
+            "\nIt can apply greyscale, crop, negative, sharp, edge-detection, equalize, autolevels, rotate, "
+            "and flip filters to BMP images.");
+    }
+    FileEntry user_args;
+    user_args.program_name_ = argv[0];
+    user_args.file_in_ = argv[1];
+    user_args.file_out_ = argv[2];
+    for (auto i = 3; i < argc;) {
+        if (argv[i][0] == '-') {
+            std::string curr_filter = argv[i];
+            auto kind = user_args.REALISED_FILTERS.find(curr_filter);
+            if (kind == user_args.REALISED_FILTERS.end()) {
+                throw std::invalid_argument("Invalid filter flag: \"" + std::string(curr_filter) +
+                                            "\" not realised in this program.");
+            }
+            user_args.chain_.push_back(FilterStep{kind->second, {}});
+            ++i;
+            while (i < argc && argv[i][0] != '-') {
+                char* end_ptr;
+                double param = strtod(argv[i], &end_ptr);
+                if (argv[i][0] == '\0' || *end_ptr != '\0') {
+                    throw std::invalid_argument("Parameters of \"" + curr_filter + "\" must be numbers. Try again.");
+                }
+                user_args.chain_.back().params_.push_back(param);
+                ++i;
+            }
+        } else {
+            throw std::invalid_argument(
+                "These are not the droids you are looking for. Use a filter flag starting with \"–\".");
+        }
+    }
+    return user_args;
+}
 
 int main(int argc, char* argv[]) {
     FileEntry user_args = Parsing(argc, argv);
     Image image = LoadFile(user_args.file_in_);
-    image = Controller(image, user_args);
+    image = Controller(std::move(image), user_args.chain_);
     SaveFile(user_args.file_out_, image);
     return 0;
 }
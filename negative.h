@@ -5,6 +5,6 @@
 // Negative filter:
 class Negative : public BaseFilter {
 public:
-    bool ParamChecker(FileEntry& user_args) override;
-    Image Implement(FileEntry& user_args, Image& original) override;
+    bool ParamChecker(const FilterStep& step) override;
+    Image Implement(const FilterStep& step, Image& original) override;
 };
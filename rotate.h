@@ -0,0 +1,14 @@
+#pragma once
+#include "file_work.h"
+#include "filters.h"
+
+// Rotation filter (clockwise, by a multiple of 90 degrees):
+class Rotate : public BaseFilter {
+private:
+    long angle_;
+    const size_t tile_ = 64;  // Side of the square block copied at once, so both images stay in cache
+
+public:
+    bool ParamChecker(const FilterStep& step) override;
+    Image Implement(const FilterStep& step, Image& original) override;
+};